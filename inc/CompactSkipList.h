@@ -0,0 +1,394 @@
+#pragma once
+#include <SkipList.h>
+#include <algorithm> // includes std::upper_bound
+#include <cstddef> // includes std::size_t
+#include <iterator>
+#include <stdexcept>
+#include <type_traits> // includes std::is_integral_v, std::is_same_v, std::conditional_t, std::make_unsigned_t
+#include <utility> // includes std::move, std::swap
+#include <vector>
+#include <iostream>
+
+
+// Сжатый SkipList для целочисленных ключей (упорядочение по возрастанию, дубликаты разрешены).
+// Нижний уровень хранит ключи отсортированными блоками: первый ключ блока записан как есть,
+// остальные - разностями с предыдущим ключом в varint (по 7 бит на байт). Верхние уровни -
+// обычный SkipList из блоков, упорядоченный по первому ключу, так что узел, вектор nexts
+// и Triple тратятся на блок, а не на каждый элемент. Итератор декодирует ключи на лету.
+// insert перекодирует блок, поэтому итератор помнит свой ключ и номер среди равных ему ключей
+// и после любой вставки заново находит свою позицию через lower_bound - как и итераторы
+// SkipList, он остается валидным после insert.
+template <typename T>
+struct CompactSkipList final{
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "CompactSkipList supports only integer keys");
+private:
+    struct Block; // inner class for encoded run of keys
+    struct BlockCmp;
+    struct ForwardIterator;
+    using index_type = SkipList<Block, BlockCmp>;
+public:
+    using iterator          = ForwardIterator;
+    using value_type        = T;
+    using reference         = std::add_lvalue_reference_t<T const>;
+    using pointer           = std::add_pointer_t<T const>;
+    using size_type         = std::size_t; // ключей может быть больше, чем помещается в unsigned
+
+    explicit CompactSkipList (size_type max_block_bytes = 256); // empty list
+
+    template <typename It>
+    CompactSkipList (It beg, It end, size_type max_block_bytes = 256); // iterator constructor
+
+    CompactSkipList (CompactSkipList<T> const &src) = default;
+
+    CompactSkipList<T>& operator=(CompactSkipList<T> const &src) = default;
+
+    CompactSkipList (CompactSkipList<T> &&src); // move constructor
+
+    CompactSkipList<T>& operator=(CompactSkipList<T> &&src); // move assignment operator
+
+    bool empty() const;
+
+    size_type size() const;
+
+    size_type block_count() const;
+
+    CompactSkipList<T>& insert(T const &element); // O(logN + block size)
+
+    template <typename It>
+    CompactSkipList<T>& insert(It beg, It end);
+
+    iterator find(T const &element) const;
+
+    size_type count(T const &element) const;
+
+    iterator lower_bound(T const &element) const;
+
+    iterator upper_bound(T const &element) const;
+
+    std::pair<iterator, iterator> equal_range(T const &element) const;
+
+    CompactSkipList<T>& clear();
+
+    iterator begin() const;
+
+    iterator end() const;
+
+    void print() const;
+
+    ~CompactSkipList () = default;
+private:
+    using unsigned_type = std::make_unsigned_t<std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>>; // bool отсекает static_assert выше
+
+    typename index_type::iterator locate(T const &element) const; // block with the largest first <= element
+
+    static void encode(Block &block, typename std::vector<T>::const_iterator beg, typename std::vector<T>::const_iterator end);
+
+    static std::vector<T> decode(Block const &block);
+
+    static unsigned_type read_varint(std::vector<unsigned char> const &bytes, size_type &offset);
+
+    static void write_varint(std::vector<unsigned char> &bytes, unsigned_type delta);
+
+    index_type index;
+    size_type nodes_size;
+    size_type max_block_bytes;
+    size_type version; // увеличивается при каждом изменении, по нему итераторы узнают, что блоки перекодированы
+};
+
+
+template <typename T>
+struct CompactSkipList<T>::Block final{
+    explicit Block(T first): first(first), bytes() { }
+    ~Block() { }
+
+    // первые ключи блоков уникальны, поэтому блок однозначно определяется первым ключом
+    bool operator==(Block const &rha) const { return first == rha.first; }
+    bool operator!=(Block const &rha) const { return !(*this == rha); }
+
+    T first;
+    std::vector<unsigned char> bytes; // varint-разности для ключей после first
+};
+
+template <typename T>
+struct CompactSkipList<T>::BlockCmp final{
+    bool operator()(Block const &lha, Block const &rha) const {
+        return lha.first < rha.first;
+    }
+};
+
+template <typename T>
+struct CompactSkipList<T>::ForwardIterator final{
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type   = int;
+    using value_type        = T;
+    using pointer           = std::add_pointer_t<T const>;
+    using reference         = std::add_lvalue_reference_t<T const>;
+
+    ForwardIterator(): owner(nullptr), block(), block_end(), offset(0), value(), rank(0), version(0), past_the_end(true) { }
+    ForwardIterator(CompactSkipList<T> const *owner, typename index_type::iterator block):
+        owner(owner), block(block), block_end(owner->index.end()), offset(0), value(), rank(0), version(owner->version),
+        past_the_end(block == block_end) {
+            if (!past_the_end) { value = this->block->first; }
+        }
+
+    reference operator*() const {
+        if (past_the_end) throw (std::out_of_range("Deferencing is impossiple"));
+        return value;
+    }
+
+    pointer operator->() const {
+        if (past_the_end) throw (std::out_of_range("Deferencing is impossiple"));
+        return std::addressof(value);
+    }
+
+    ForwardIterator& operator++() {
+        if (past_the_end) throw (std::out_of_range("Iterator increment is out of range"));
+        this->revalidate();
+        auto previous = value;
+        if (offset < block->bytes.size()) {
+            value = static_cast<T>(static_cast<unsigned_type>(value) + read_varint(block->bytes, offset));
+        } else {
+            ++block;
+            offset = 0;
+            past_the_end = (block == block_end);
+            if (!past_the_end) { value = block->first; }
+        }
+        // равные ключи всегда лежат в одном блоке, поэтому rank сбрасывается на границе блоков
+        rank = (!past_the_end && value == previous) ? rank + 1 : 0;
+        return *this;
+    }
+
+    ForwardIterator operator++(int) { auto tmp(*this); ++(*this); return tmp; }
+
+    bool operator==(ForwardIterator const &rha) {
+        if (this->past_the_end || rha.past_the_end) return this->past_the_end == rha.past_the_end;
+        auto other = rha;
+        this->revalidate();
+        other.revalidate();
+        return this->block == other.block && this->offset == other.offset;
+    }
+    bool operator!=(ForwardIterator const &rha) { return !(*this == rha); }
+
+    // после insert блок мог быть перекодирован или разделен: ищем тот же ключ с тем же номером среди равных
+    void revalidate() {
+        if (past_the_end || version == owner->version) return;
+        auto fresh = owner->lower_bound(value);
+        for (auto i = 0u; i < rank; ++i) { ++fresh; }
+        *this = fresh;
+    }
+
+    CompactSkipList<T> const *owner;
+    typename index_type::iterator block;
+    typename index_type::iterator block_end;
+    size_type offset; // позиция следующей varint-разности в block->bytes
+    T value;
+    size_type rank; // сколько равных value ключей стоит перед этим
+    size_type version; // owner->version на момент, когда offset был верен
+    bool past_the_end;
+};
+
+template <typename T>
+CompactSkipList<T>::CompactSkipList (size_type max_block_bytes):
+    index(),
+    nodes_size(0),
+    max_block_bytes(max_block_bytes < 2 ? 2 : max_block_bytes),
+    version(0) { }
+
+template <typename T>
+template <typename It>
+CompactSkipList<T>::CompactSkipList (It beg, It end, size_type max_block_bytes): CompactSkipList(max_block_bytes) {
+    this->insert(beg, end);
+}
+
+template <typename T>
+CompactSkipList<T>::CompactSkipList (CompactSkipList<T> &&src):
+    index(std::move(src.index)),
+    nodes_size(std::move(src.nodes_size)),
+    max_block_bytes(std::move(src.max_block_bytes)),
+    version(std::move(src.version)) {
+        src.nodes_size = 0;
+    }
+
+template <typename T>
+CompactSkipList<T>& CompactSkipList<T>::operator=(CompactSkipList<T> &&src) {
+    if (this == std::addressof(src)) return *this;
+    CompactSkipList<T> tmp(std::move(src));
+    std::swap(index, tmp.index);
+    std::swap(nodes_size, tmp.nodes_size);
+    std::swap(max_block_bytes, tmp.max_block_bytes);
+    std::swap(version, tmp.version);
+    version = tmp.version + 1; // старые итераторы по this должны заново искать свою позицию
+    return *this;
+}
+
+template <typename T>
+bool CompactSkipList<T>::empty() const {
+    return nodes_size == 0;
+}
+
+template <typename T>
+typename CompactSkipList<T>::size_type CompactSkipList<T>::size() const {
+    return nodes_size;
+}
+
+template <typename T>
+typename CompactSkipList<T>::size_type CompactSkipList<T>::block_count() const {
+    return index.size();
+}
+
+template <typename T>
+typename CompactSkipList<T>::unsigned_type CompactSkipList<T>::read_varint(std::vector<unsigned char> const &bytes, size_type &offset) {
+    unsigned_type delta = 0;
+    for (auto shift = 0u; ; shift += 7) {
+        auto byte = bytes[offset++];
+        delta |= static_cast<unsigned_type>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) { return delta; }
+    }
+}
+
+template <typename T>
+void CompactSkipList<T>::write_varint(std::vector<unsigned char> &bytes, unsigned_type delta) {
+    while (delta >= 0x80) {
+        bytes.push_back(static_cast<unsigned char>(delta | 0x80));
+        delta >>= 7;
+    }
+    bytes.push_back(static_cast<unsigned char>(delta));
+}
+
+template <typename T>
+void CompactSkipList<T>::encode(Block &block, typename std::vector<T>::const_iterator beg, typename std::vector<T>::const_iterator end) {
+    block.first = *beg;
+    block.bytes.clear();
+    for (auto prev = beg++; beg != end; prev = beg++) {
+        write_varint(block.bytes, static_cast<unsigned_type>(*beg) - static_cast<unsigned_type>(*prev));
+    }
+    block.bytes.shrink_to_fit();
+}
+
+template <typename T>
+std::vector<T> CompactSkipList<T>::decode(Block const &block) {
+    std::vector<T> values(1, block.first);
+    size_type offset = 0;
+    while (offset < block.bytes.size()) {
+        values.push_back(static_cast<T>(static_cast<unsigned_type>(values.back()) + read_varint(block.bytes, offset)));
+    }
+    return values;
+}
+
+template <typename T>
+typename CompactSkipList<T>::index_type::iterator CompactSkipList<T>::locate(T const &element) const {
+    auto block = index.upper_bound(Block(element));
+    if (block == index.begin()) { return block; } // element меньше всех ключей - первый блок
+    return std::prev(block);
+}
+
+template <typename T>
+CompactSkipList<T>& CompactSkipList<T>::insert(T const &element) {
+    ++version;
+    if (this->empty()) {
+        index.insert(Block(element));
+        ++nodes_size;
+        return *this;
+    }
+    auto &block = *this->locate(element);
+    auto values = decode(block);
+    values.insert(std::upper_bound(values.begin(), values.end(), element), element);
+    encode(block, values.begin(), values.end());
+    ++nodes_size;
+    if (block.bytes.size() <= max_block_bytes) { return *this; }
+    // блок переполнен: делим ближе к середине, но так, чтобы дубликаты не разошлись
+    // по разным блокам (иначе первые ключи блоков перестанут быть уникальными)
+    auto mid = values.size() / 2;
+    auto pos = 0u;
+    for (auto i = 0u; i < values.size(); ++i) {
+        if (mid + i < values.size() && values[mid + i - 1] < values[mid + i]) {
+            pos = mid + i; break;
+        }
+        if (mid > i + 1 && values[mid - i - 2] < values[mid - i - 1]) {
+            pos = mid - i - 1; break;
+        }
+    }
+    if (pos == 0) { return *this; } // блок из одинаковых ключей не делится
+    Block tail(values[pos]);
+    encode(tail, values.begin() + pos, values.end());
+    encode(block, values.begin(), values.begin() + pos);
+    index.insert(tail);
+    return *this;
+}
+
+template <typename T>
+template <typename It>
+CompactSkipList<T>& CompactSkipList<T>::insert(It beg, It end) {
+    while (beg != end) {
+        this->insert(*beg++);
+    }
+    return *this;
+}
+
+template <typename T>
+typename CompactSkipList<T>::iterator CompactSkipList<T>::find(T const &element) const {
+    auto lower_bound = this->lower_bound(element);
+    if (lower_bound == this->end() || element < *lower_bound) { return this->end(); }
+    return lower_bound;
+}
+
+template <typename T>
+typename CompactSkipList<T>::size_type CompactSkipList<T>::count(T const &element) const {
+    auto curr = this->lower_bound(element);
+    size_type count = 0;
+    while (curr != this->end() && *curr == element) { ++count; ++curr; }
+    return count;
+}
+
+template <typename T>
+typename CompactSkipList<T>::iterator CompactSkipList<T>::lower_bound(T const &element) const {
+    if (this->empty()) { return this->end(); }
+    auto curr = iterator(this, this->locate(element));
+    auto block = curr.block;
+    // внутри блока ключи идут подряд, следующий блок начинается с ключа > element
+    while (curr != this->end() && curr.block == block && *curr < element) { ++curr; }
+    return curr;
+}
+
+template <typename T>
+typename CompactSkipList<T>::iterator CompactSkipList<T>::upper_bound(T const &element) const {
+    auto curr = this->lower_bound(element);
+    while (curr != this->end() && !(element < *curr)) { ++curr; }
+    return curr;
+}
+
+template <typename T>
+std::pair<typename CompactSkipList<T>::iterator, typename CompactSkipList<T>::iterator> CompactSkipList<T>::equal_range(T const &element) const {
+    return std::pair(this->lower_bound(element), this->upper_bound(element));
+}
+
+template <typename T>
+CompactSkipList<T>& CompactSkipList<T>::clear() {
+    ++version;
+    index.clear();
+    nodes_size = 0;
+    return *this;
+}
+
+template <typename T>
+typename CompactSkipList<T>::iterator CompactSkipList<T>::begin() const { return iterator(this, index.begin()); }
+
+template <typename T>
+typename CompactSkipList<T>::iterator CompactSkipList<T>::end() const { return iterator(); }
+
+template <typename T>
+void CompactSkipList<T>::print() const {
+    if (this->empty()) {
+        std::cout << "empty list\n";
+        return;
+    }
+    for (auto block = index.begin(); block != index.end(); ++block) {
+        auto values = decode(*block);
+        std::cout << "block " << block->first << " (" << values.size() << " keys, " << block->bytes.size() << " bytes):";
+        for (auto const &value : values) {
+            std::cout << ' ' << value;
+        }
+        std::cout << '\n';
+    }
+    std::cout << '\n';
+}
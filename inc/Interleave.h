@@ -0,0 +1,106 @@
+#pragma once
+#include <coroutine>
+#include <cstddef> // includes std::size_t
+#include <exception> // includes std::exception_ptr
+#include <utility> // includes std::exchange
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h> // includes _mm_prefetch
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+#include <intrin.h> // includes __prefetch
+#endif
+
+// Корутина поиска: приостанавливается перед каждым разыменованием узла, выдав prefetch,
+// а interleave гоняет много таких поисков по кругу в одном потоке, пока память подгружается.
+template <typename R>
+struct Lookup final{
+    struct promise_type final{
+        Lookup get_return_object() { return Lookup(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(R value) { result = std::move(value); }
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        R result;
+        std::exception_ptr exception;
+    };
+
+    Lookup(): handle(nullptr) { }
+    explicit Lookup(std::coroutine_handle<promise_type> handle): handle(handle) { }
+
+    Lookup(Lookup const &src) = delete;
+    Lookup& operator=(Lookup const &src) = delete;
+
+    Lookup(Lookup &&src): handle(std::exchange(src.handle, nullptr)) { }
+    Lookup& operator=(Lookup &&src) {
+        Lookup tmp(std::move(src));
+        std::swap(tmp.handle, this->handle);
+        return *this;
+    }
+
+    bool done() const { return !handle || handle.done(); }
+
+    void resume() { if (!this->done()) handle.resume(); }
+
+    R result() {
+        if (handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+        return std::move(handle.promise().result);
+    }
+
+    ~Lookup() { if (handle) handle.destroy(); }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// подсказка процессору загрузить строку кэша с address; на неизвестном компиляторе ничего не делает
+inline void prefetch(void const *address) {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_prefetch(static_cast<char const *>(address), _MM_HINT_T0);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+// co_await Prefetch(p) - запросить строку кэша с p и уступить поток следующему поиску
+struct Prefetch final{
+    explicit Prefetch(void const *address): address(address) { }
+    bool await_ready() const noexcept {
+        prefetch(address);
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<>) const noexcept { }
+    void await_resume() const noexcept { }
+
+    void const *address;
+};
+
+// Запускает start(key) для каждого ключа из [beg, end), держа одновременно не больше width
+// поисков и возобновляя их по очереди. Результаты возвращаются в порядке ключей.
+template <typename R, typename It, typename Start>
+std::vector<R> interleave(It beg, It end, unsigned width, Start start) {
+    std::vector<R> results;
+    std::vector<Lookup<R>> slots(width == 0 ? 1 : width);
+    std::vector<std::size_t> positions(slots.size(), 0);
+    auto active = 0u;
+    do {
+        for (auto idx = 0u; idx < slots.size(); ++idx) {
+            if (slots[idx].done() && slots[idx].handle) { // поиск закончен - забираем результат
+                results[positions[idx]] = slots[idx].result();
+                slots[idx] = Lookup<R>();
+                --active;
+            }
+            if (!slots[idx].handle && beg != end) { // свободный слот - берем следующий ключ
+                positions[idx] = results.size();
+                results.emplace_back();
+                slots[idx] = start(*beg++);
+                ++active;
+            }
+            slots[idx].resume();
+        }
+    } while (active);
+    return results;
+}
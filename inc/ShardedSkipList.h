@@ -0,0 +1,367 @@
+#pragma once
+#include <SkipList.h>
+#include <algorithm> // includes std::upper_bound
+#include <atomic>
+#include <functional> // includes std::less
+#include <iterator>
+#include <memory> // includes std::unique_ptr
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+#include <iostream>
+
+
+// Контейнер, разбитый по диапазонам ключей на несколько SkipList (шардов).
+// Шард i хранит элементы из [bounds[i-1], bounds[i]), все дубликаты одного значения
+// всегда лежат в одном шарде. insert, erase и count потокобезопасны: индекс границ защищен
+// shared_mutex, каждый шард - своим mutex, поэтому вставки в разные шарды идут параллельно.
+// Обход итератором не синхронизирован с конкурентными вставками.
+template <typename T, typename Cmp = std::less<T>>
+struct ShardedSkipList final{
+private:
+    struct Shard; // inner class for one partition
+    struct ForwardIterator;
+public:
+    using shard_type        = SkipList<T, Cmp>;
+    using iterator          = ForwardIterator;
+    using value_type        = T;
+    using reference         = std::add_lvalue_reference_t<T>;
+    using pointer           = std::add_pointer_t<T>;
+    using size_type         = typename SkipList<T, Cmp>::size_type;
+
+    explicit ShardedSkipList (size_type max_shard_size = 1024); // empty list with one shard
+
+    template <typename It>
+    ShardedSkipList (It beg, It end, size_type max_shard_size = 1024); // iterator constructor
+
+    ShardedSkipList (ShardedSkipList<T, Cmp> const &src) = delete; // mutexes are not copyable
+
+    ShardedSkipList<T, Cmp>& operator=(ShardedSkipList<T, Cmp> const &src) = delete;
+
+    bool empty() const;
+
+    size_type size() const;
+
+    size_type shard_count() const;
+
+    ShardedSkipList<T, Cmp>& insert(T const &element); // thread-safe, O(logN) + amortized split
+
+    template <typename It>
+    ShardedSkipList<T, Cmp>& insert(It beg, It end);
+
+    ShardedSkipList<T, Cmp>& erase(T const &element); // thread-safe, removes all equal elements, O(shard size)
+
+    iterator find(T const &element) const;
+
+    size_type count(T const &element) const; // thread-safe
+
+    iterator lower_bound(T const &element) const;
+
+    iterator upper_bound(T const &element) const;
+
+    ShardedSkipList<T, Cmp>& clear();
+
+    iterator begin() const;
+
+    iterator end() const;
+
+    void print() const;
+
+    ~ShardedSkipList () = default;
+private:
+    size_type route(T const &element) const; // caller holds index_mutex
+
+    void split(size_type idx); // caller holds index_mutex exclusively
+
+    void merge_small(size_type idx); // caller holds index_mutex exclusively
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<T> bounds; // bounds[i] - наименьший ключ шарда i+1
+    mutable std::shared_mutex index_mutex;
+    std::atomic<size_type> nodes_size;
+    size_type max_shard_size;
+    Cmp c;
+};
+
+
+template <typename T, typename Cmp>
+struct ShardedSkipList<T, Cmp>::Shard final{
+    Shard(): list(), mutex() { }
+    template <typename It>
+    Shard(It beg, It end): list(beg, end), mutex() { }
+    ~Shard() { }
+
+    SkipList<T, Cmp> list;
+    mutable std::mutex mutex;
+};
+
+template <typename T, typename Cmp>
+struct ShardedSkipList<T, Cmp>::ForwardIterator final{
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type   = int;
+    using value_type        = T;
+    using pointer           = std::add_pointer_t<T>;
+    using reference         = std::add_lvalue_reference_t<T>;
+
+    ForwardIterator(): owner(nullptr), shard(0), current() { }
+    ForwardIterator(ShardedSkipList<T, Cmp> const *owner, size_type shard, typename SkipList<T, Cmp>::iterator current):
+        owner(owner), shard(shard), current(current) { skip_exhausted(); }
+
+    reference operator*() {
+        if (!owner || shard == owner->shards.size()) throw (std::out_of_range("Deferencing is impossiple"));
+        return *current;
+    }
+
+    pointer operator->() {
+        if (!owner || shard == owner->shards.size()) throw (std::out_of_range("Deferencing is impossiple"));
+        return std::addressof(*current);
+    }
+
+    ForwardIterator& operator++() {
+        if (!owner || shard == owner->shards.size()) throw (std::out_of_range("Iterator increment is out of range"));
+        ++current;
+        skip_exhausted();
+        return *this;
+    }
+
+    ForwardIterator operator++(int) { auto tmp(*this); ++(*this); return tmp; }
+
+    bool operator==(ForwardIterator const &rha) {
+        if (this->owner != rha.owner || this->shard != rha.shard) return false;
+        return !owner || shard == owner->shards.size() || this->current == rha.current;
+    }
+    bool operator!=(ForwardIterator const &rha) { return !(*this == rha); }
+
+    // переходит к началу следующего непустого шарда, если текущий закончился
+    void skip_exhausted() {
+        if (!owner) return;
+        while (shard < owner->shards.size() && current == owner->shards[shard]->list.end()) {
+            if (++shard < owner->shards.size()) {
+                current = owner->shards[shard]->list.begin();
+            }
+        }
+        if (shard == owner->shards.size()) {
+            current = typename SkipList<T, Cmp>::iterator();
+        }
+    }
+
+    ShardedSkipList<T, Cmp> const *owner;
+    size_type shard;
+    typename SkipList<T, Cmp>::iterator current;
+};
+
+template <typename T, typename Cmp>
+ShardedSkipList<T, Cmp>::ShardedSkipList (size_type max_shard_size):
+    shards(),
+    bounds(),
+    index_mutex(),
+    nodes_size(0),
+    max_shard_size(max_shard_size < 2 ? 2 : max_shard_size),
+    c() {
+        shards.push_back(std::make_unique<Shard>());
+    }
+
+template <typename T, typename Cmp>
+template <typename It>
+ShardedSkipList<T, Cmp>::ShardedSkipList (It beg, It end, size_type max_shard_size): ShardedSkipList(max_shard_size) {
+    this->insert(beg, end);
+}
+
+template <typename T, typename Cmp>
+bool ShardedSkipList<T, Cmp>::empty() const {
+    return nodes_size == 0;
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::size_type ShardedSkipList<T, Cmp>::size() const {
+    return nodes_size;
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::size_type ShardedSkipList<T, Cmp>::shard_count() const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    return shards.size();
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::size_type ShardedSkipList<T, Cmp>::route(T const &element) const {
+    return std::upper_bound(bounds.begin(), bounds.end(), element, c) - bounds.begin();
+}
+
+template <typename T, typename Cmp>
+ShardedSkipList<T, Cmp>& ShardedSkipList<T, Cmp>::insert(T const &element) {
+    bool overflow = false;
+    {
+        std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+        auto &shard = *shards[route(element)];
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        shard.list.insert(element);
+        ++nodes_size;
+        // шард из одного значения делить нечего - не берем эксклюзивную блокировку зря
+        overflow = shard.list.size() > max_shard_size && c(*shard.list.begin(), *shard.list.rbegin());
+    }
+    if (overflow) {
+        std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+        auto idx = route(element); // пока ждали блокировку, шард мог уже разделить другой поток
+        if (shards[idx]->list.size() > max_shard_size) {
+            this->split(idx);
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Cmp>
+template <typename It>
+ShardedSkipList<T, Cmp>& ShardedSkipList<T, Cmp>::insert(It beg, It end) {
+    while (beg != end) {
+        this->insert(*beg++);
+    }
+    return *this;
+}
+
+template <typename T, typename Cmp>
+ShardedSkipList<T, Cmp>& ShardedSkipList<T, Cmp>::erase(T const &element) {
+    bool underflow = false;
+    {
+        std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+        auto &shard = *shards[route(element)];
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        auto removed = shard.list.count(element);
+        if (removed == 0) { return *this; }
+        // шард пересобирается без element: размер шарда ограничен max_shard_size
+        std::vector<T> elements;
+        elements.reserve(shard.list.size() - removed);
+        for (auto it = shard.list.begin(); it != shard.list.end(); ++it) {
+            if (c(*it, element) || c(element, *it)) { elements.push_back(*it); }
+        }
+        shard.list = SkipList<T, Cmp>(elements.begin(), elements.end());
+        nodes_size -= removed;
+        underflow = shards.size() > 1 && shard.list.size() <= max_shard_size / 4;
+    }
+    if (underflow) {
+        std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+        this->merge_small(route(element)); // индекс мог измениться, пока ждали блокировку
+    }
+    return *this;
+}
+
+template <typename T, typename Cmp>
+void ShardedSkipList<T, Cmp>::split(size_type idx) {
+    auto &list = shards[idx]->list;
+    if (list.empty() || !c(*list.begin(), *list.rbegin())) { return; } // все элементы шарда равны, делить нечего
+    std::vector<T> elements;
+    elements.reserve(list.size());
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        elements.push_back(*it);
+    }
+    // граница не должна разрезать группу дубликатов: ищем ближайшую к середине
+    // позицию, где значение строго возрастает
+    auto mid = elements.size() / 2;
+    auto pos = 0u;
+    for (auto i = 0u; i < elements.size(); ++i) {
+        if (mid + i < elements.size() && mid + i > 0 && c(elements[mid + i - 1], elements[mid + i])) {
+            pos = mid + i; break;
+        }
+        if (mid > i + 1 && c(elements[mid - i - 2], elements[mid - i - 1])) {
+            pos = mid - i - 1; break;
+        }
+    }
+    shards[idx] = std::make_unique<Shard>(elements.begin(), elements.begin() + pos);
+    shards.insert(shards.begin() + idx + 1, std::make_unique<Shard>(elements.begin() + pos, elements.end()));
+    bounds.insert(bounds.begin() + idx, elements[pos]);
+}
+
+template <typename T, typename Cmp>
+void ShardedSkipList<T, Cmp>::merge_small(size_type idx) {
+    // смотрим только на шард idx и его соседей: пустой шард выбрасывается из индекса,
+    // шард меньше четверти порога вливается в меньшего соседа, если вместе они не больше порога
+    // (половины только что разделенного шарда вместе больше порога и так не склеиваются)
+    auto size = shards[idx]->list.size();
+    if (shards.size() == 1 || size > max_shard_size / 4) { return; }
+    if (size == 0) {
+        shards.erase(shards.begin() + idx);
+        bounds.erase(bounds.begin() + (idx == 0 ? 0 : idx - 1)); // диапазон забирает сосед
+        return;
+    }
+    auto left = idx;
+    if (idx + 1 == shards.size() || (idx > 0 && shards[idx - 1]->list.size() < shards[idx + 1]->list.size())) {
+        left = idx - 1;
+    }
+    if (shards[left]->list.size() + shards[left + 1]->list.size() > max_shard_size) { return; }
+    std::vector<T> elements;
+    elements.reserve(shards[left]->list.size() + shards[left + 1]->list.size());
+    for (auto i = left; i < left + 2; ++i) {
+        for (auto it = shards[i]->list.begin(); it != shards[i]->list.end(); ++it) {
+            elements.push_back(*it);
+        }
+    }
+    shards[left] = std::make_unique<Shard>(elements.begin(), elements.end());
+    shards.erase(shards.begin() + left + 1);
+    bounds.erase(bounds.begin() + left);
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::iterator ShardedSkipList<T, Cmp>::find(T const &element) const {
+    auto lower_bound = this->lower_bound(element);
+    if (lower_bound == this->end() || c(element, *lower_bound)) { return this->end(); }
+    return lower_bound;
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::size_type ShardedSkipList<T, Cmp>::count(T const &element) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    auto &shard = *shards[route(element)];
+    std::lock_guard<std::mutex> shard_lock(shard.mutex);
+    return shard.list.count(element);
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::iterator ShardedSkipList<T, Cmp>::lower_bound(T const &element) const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    auto idx = route(element);
+    std::lock_guard<std::mutex> shard_lock(shards[idx]->mutex);
+    return iterator(this, idx, shards[idx]->list.lower_bound(element));
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::iterator ShardedSkipList<T, Cmp>::upper_bound(T const &element) const {
+    auto curr = this->lower_bound(element);
+    while (curr != this->end() && (!c(element, *curr))) { ++curr; }
+    return curr;
+}
+
+template <typename T, typename Cmp>
+ShardedSkipList<T, Cmp>& ShardedSkipList<T, Cmp>::clear() {
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex);
+    shards.clear();
+    bounds.clear();
+    shards.push_back(std::make_unique<Shard>());
+    nodes_size = 0;
+    return *this;
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::iterator ShardedSkipList<T, Cmp>::begin() const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    return iterator(this, 0, shards[0]->list.begin());
+}
+
+template <typename T, typename Cmp>
+typename ShardedSkipList<T, Cmp>::iterator ShardedSkipList<T, Cmp>::end() const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    return iterator(this, shards.size(), typename SkipList<T, Cmp>::iterator());
+}
+
+template <typename T, typename Cmp>
+void ShardedSkipList<T, Cmp>::print() const {
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex);
+    for (auto idx = 0u; idx < shards.size(); ++idx) {
+        std::cout << "shard " << idx << ", size = " << shards[idx]->list.size();
+        if (idx > 0) {
+            std::cout << ", from " << bounds[idx - 1];
+        }
+        std::cout << ":\n";
+        shards[idx]->list.print();
+    }
+}
@@ -5,6 +5,9 @@
 #include <vector>
 #include <utility> // includes std::pair
 #include <Add.h> // random add
+#if defined(__cpp_impl_coroutine)
+#include <Interleave.h> // coroutine lookups, C++20 only
+#endif
 #include <memory>
 #include <iostream>
 
@@ -62,6 +65,14 @@ public:
 
     std::pair<iterator, iterator> equal_range(T const &element) const;
 
+#if defined(__cpp_impl_coroutine)
+    template <typename It>
+    std::vector<iterator> find_batch(It beg, It end, unsigned width = 16) const; // interleaved find on one thread
+
+    template <typename It>
+    std::vector<iterator> lower_bound_batch(It beg, It end, unsigned width = 16) const;
+#endif
+
     iterator begin() const;
 
     iterator end() const;
@@ -74,6 +85,10 @@ public:
 
     ~SkipList () { this->clear();}
 private:
+#if defined(__cpp_impl_coroutine)
+    Lookup<iterator> lower_bound_task(T element) const; // lower_bound, suspending before each node access
+#endif
+
     std::vector<std::shared_ptr<Triple>> head;
     std::vector<std::shared_ptr<Triple>> tail;
     Cmp c;
@@ -470,6 +485,78 @@ typename SkipList<T, Cmp>::iterator SkipList<T, Cmp>::lower_bound(T const &eleme
     return this->end();
 }
 
+#if defined(__cpp_impl_coroutine)
+template <typename T, typename Cmp>
+Lookup<typename SkipList<T, Cmp>::iterator> SkipList<T, Cmp>::lower_bound_task(T element) const {
+    // тот же спуск, что и в lower_bound, но по сырым указателям Triple (список не меняется,
+    // пока идет пакетный поиск, и счетчики shared_ptr не нужны): перед чтением каждого
+    // Triple, его Node и буфера nexts выдаем prefetch и уступаем поток другим поискам
+    if (head.empty()) {
+        co_return iterator(); // empty iterator
+    }
+    auto idx = head.size() - 1;
+    Triple *current_triple = head[idx].get();
+    co_await Prefetch(current_triple);
+    co_await Prefetch(current_triple->node.get());
+    while (c(element, current_triple->node->element)) { // elem < curr
+        if (idx == 0) {
+            co_return iterator(head[0]);
+        }
+        --idx;
+        current_triple = head[idx].get();
+        co_await Prefetch(current_triple);
+        co_await Prefetch(current_triple->node.get());
+    }
+    if (!c(current_triple->node->element, element)) { //elem == curr
+        co_return iterator(current_triple->node->nexts[0]);
+    }
+    while (true) {
+        while (!current_triple->next) {
+            if (idx == 0) {
+                co_return this->end();
+            }
+            --idx;
+            co_await Prefetch(current_triple->node->nexts.data() + idx);
+            current_triple = current_triple->node->nexts[idx].get();
+            co_await Prefetch(current_triple);
+        }
+        co_await Prefetch(current_triple->next.get());
+        Triple *next_triple = current_triple->next.get();
+        co_await Prefetch(next_triple->node.get());
+        if (c(element, next_triple->node->element)) { //elem < next
+            if (idx == 0) {
+                co_return iterator(next_triple->node->nexts[0]);
+            }
+            --idx;
+            co_await Prefetch(current_triple->node->nexts.data() + idx);
+            current_triple = current_triple->node->nexts[idx].get();
+            co_await Prefetch(current_triple);
+        } else if (c(next_triple->node->element, element)) { //next < elem
+            current_triple = next_triple;
+        } else { //next == elem
+            co_return iterator(next_triple->node->nexts[0]);
+        }
+    }
+}
+
+template <typename T, typename Cmp>
+template <typename It>
+std::vector<typename SkipList<T, Cmp>::iterator> SkipList<T, Cmp>::lower_bound_batch(It beg, It end, unsigned width) const {
+    return interleave<iterator>(beg, end, width, [this](T const &element) { return this->lower_bound_task(element); });
+}
+
+template <typename T, typename Cmp>
+template <typename It>
+std::vector<typename SkipList<T, Cmp>::iterator> SkipList<T, Cmp>::find_batch(It beg, It end, unsigned width) const {
+    std::vector<T> elements(beg, end);
+    auto found = this->lower_bound_batch(elements.begin(), elements.end(), width);
+    for (auto idx = 0u; idx < found.size(); ++idx) {
+        if (!found[idx].get_current() || c(elements[idx], *found[idx])) { found[idx] = this->end(); }
+    }
+    return found;
+}
+#endif
+
 template <typename T, typename Cmp>
 typename SkipList<T, Cmp>::iterator SkipList<T, Cmp>::upper_bound(T const &element) const {
     auto curr = this->lower_bound(element);
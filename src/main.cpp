@@ -1,5 +1,8 @@
 #include <SkipList.h>
+#include <ShardedSkipList.h>
+#include <CompactSkipList.h>
 #include <iostream>
+#include <thread>
 
 struct Luntik {
     Luntik(int age): age(age) {
@@ -96,5 +99,47 @@ int main() {
     std::cout << "Luntik skiplist, size = " << luntiks.size() << ":\n";
     luntiks.print();
 
+    std::cout << "construct sharded skiplist (5) with at most 4 elements per shard out of arr and arr1:\n";
+    ShardedSkipList<int> l5(std::begin(arr), std::end(arr), 4);
+    l5.insert(std::begin(arr1), std::end(arr1));
+    std::cout << "sharded skiplist (5), size = " << l5.size() << ", shards = " << l5.shard_count() << ":\n";
+    l5.print();
+
+    std::cout << "insert 100..199 to sharded skiplist (5) from 4 threads:\n";
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&l5, t]() {
+            for (int x = 100 + t; x < 200; x += 4) { l5.insert(x); }
+        });
+    }
+    for (auto &writer : writers) { writer.join(); }
+    std::cout << "sharded skiplist (5), size = " << l5.size() << ", shards = " << l5.shard_count() << ":\n";
+    for (auto it = l5.begin(); it != l5.end(); ++it) {
+        std::cout << *it << " ";
+    } std::cout << '\n';
+    std::cout << "count of 10 in (5): " << l5.count(10) << ", lower_bound of 12 in (5): " << *l5.lower_bound(12) << "\n\n";
+
+    std::cout << "erase 100..199 from sharded skiplist (5), emptied shards are merged:\n";
+    for (int x = 100; x < 200; ++x) { l5.erase(x); }
+    std::cout << "sharded skiplist (5), size = " << l5.size() << ", shards = " << l5.shard_count() << ":\n";
+    l5.print();
+
+    std::cout << "construct compact skiplist (6) with at most 4 bytes per block out of arr, arr1 and 100..119:\n";
+    CompactSkipList<int> l6(std::begin(arr), std::end(arr), 4);
+    l6.insert(std::begin(arr1), std::end(arr1));
+    for (int x = 100; x < 120; ++x) { l6.insert(x); }
+    std::cout << "compact skiplist (6), size = " << l6.size() << ", blocks = " << l6.block_count() << ":\n";
+    l6.print();
+    std::cout << "count of 6 in (6): " << l6.count(6) << ", lower_bound of 12 in (6): " << *l6.lower_bound(12) << "\n\n";
+
+#if defined(__cpp_impl_coroutine)
+    std::cout << "find 3, 4, 6, 11 in skiplist (2) with interleaved coroutine lookups:\n";
+    int keys[] = {3, 4, 6, 11};
+    auto found = l2.find_batch(std::begin(keys), std::end(keys));
+    for (auto idx = 0u; idx < found.size(); ++idx) {
+        std::cout << keys[idx] << (found[idx] == l2.end() ? " not found" : " found") << '\n';
+    } std::cout << '\n';
+#endif
+
     return 0;
 }
\ No newline at end of file